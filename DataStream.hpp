@@ -7,6 +7,11 @@
 #include <string>
 #include <map>
 #include <set>
+#include <memory>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#define VANISH_SERIALIZE_IOVEC // 只有POSIX平台提供iovec, 借用模式依赖它
+#endif
 
 namespace Vanish
 {
@@ -34,12 +39,27 @@ namespace Vanish
             BIG_ENDIAN
         };
 
+        class DataStreamPool;
+
         class DataStream
         {
+            friend class DataStreamPool;
+
+        private:
+            // 借用的外部数据, 不拷贝进m_buffer, 输出时作为独立的iovec段
+            struct BorrowedSegment
+            {
+                int offset; // 在m_buffer中的插入位置
+                const char *data;
+                int length;
+            };
+
         private:
             std::vector<char> m_buffer;
             int m_position = 0;
             ByteOrder m_byteOrder;
+            std::vector<BorrowedSegment> m_borrowed;
+            int m_borrowThreshold = 0; // 0表示关闭借用
 
         public:
             DataStream() {m_byteOrder = GetSystemByteOrder();}
@@ -47,6 +67,18 @@ namespace Vanish
 
         public:
             void Show() const;
+            void Clear(); // 清空数据但保留容量, 便于复用
+            void Reset(); // 只回退读取位置, 可重新读取已写入的数据
+            int Size() const { return m_buffer.size(); } // 只包含m_buffer中的字节, 不含借用的数据
+            int TotalSize() const;                         // 编码后的完整长度, 包含借用的数据
+
+#ifdef VANISH_SERIALIZE_IOVEC
+            // 字符串长度不小于threshold时只记录引用, 调用者需保证数据在输出完成前有效
+            // 借用模式下的流只用于输出, 持有借用数据时所有Read都会返回false
+            void SetBorrowThreshold(int threshold) { m_borrowThreshold = threshold; }
+            // 可直接用于writev/sendmsg, 注意段数可能超过IOV_MAX(Linux上为1024), 超过时需分批发送
+            void GetSegments(std::vector<iovec> &segments) const;
+#endif
 
         public:
             void Write(bool data);
@@ -151,6 +183,60 @@ namespace Vanish
             std::cout << std::endl;
         }
 
+        void DataStream::Clear()
+        {
+            m_buffer.clear(); // clear函数: 只销毁元素, 不释放底层内存
+            m_borrowed.clear();
+            m_position = 0;
+        }
+
+        void DataStream::Reset()
+        {
+            m_position = 0;
+        }
+
+        int DataStream::TotalSize() const
+        {
+            int size = m_buffer.size();
+            for (const BorrowedSegment &borrowed : m_borrowed)
+            {
+                size += borrowed.length;
+            }
+            return size;
+        }
+
+#ifdef VANISH_SERIALIZE_IOVEC
+        void DataStream::GetSegments(std::vector<iovec> &segments) const
+        {
+            segments.clear();
+            segments.reserve(m_borrowed.size() * 2 + 1);
+            int offset = 0;
+            for (const BorrowedSegment &borrowed : m_borrowed)
+            {
+                if (borrowed.offset > offset)
+                {
+                    iovec header;
+                    header.iov_base = (void *)&m_buffer[offset];
+                    header.iov_len = borrowed.offset - offset;
+                    segments.push_back(header);
+                    offset = borrowed.offset;
+                }
+                iovec payload;
+                payload.iov_base = (void *)borrowed.data;
+                payload.iov_len = borrowed.length;
+                segments.push_back(payload);
+            }
+            int size = m_buffer.size();
+            if (size > offset)
+            {
+                iovec tail;
+                tail.iov_base = (void *)&m_buffer[offset];
+                tail.iov_len = size - offset;
+                segments.push_back(tail);
+            }
+        }
+#endif
+
         void DataStream::Reserve(int length)
         {
             int size = m_buffer.size();
@@ -260,11 +346,16 @@ namespace Vanish
             Write((char *)&type, sizeof(char)); // 写入数据类型
             int32_t length = data.length();
             Write(length); // 写入字符串长度
+            if (m_borrowThreshold > 0 && length >= m_borrowThreshold)
+            {
+                m_borrowed.push_back({(int)m_buffer.size(), data.c_str(), length}); // 大块数据只记录引用, 避免拷贝
+                return;
+            }
             Write(data.c_str(), length);              // 写入字符串内容
         }
         bool DataStream::Read(bool &data)
         {
-            if (m_buffer[m_position] != DataType::BOOL)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::BOOL)
             {
                 return false;
             }
@@ -274,7 +365,7 @@ namespace Vanish
         }
         bool DataStream::Read(char &data)
         {
-            if (m_buffer[m_position] != DataType::CHAR)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::CHAR)
             {
                 return false;
             }
@@ -284,7 +375,7 @@ namespace Vanish
         }
         bool DataStream::Read(int32_t &data)
         {
-            if (m_buffer[m_position] != DataType::INT32)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::INT32)
             {
                 return false;
             }
@@ -301,7 +392,7 @@ namespace Vanish
         }
         bool DataStream::Read(int64_t &data)
         {
-            if (m_buffer[m_position] != DataType::INT64)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::INT64)
             {
                 return false;
             }
@@ -318,7 +409,7 @@ namespace Vanish
         }
         bool DataStream::Read(float &data)
         {
-            if (m_buffer[m_position] != DataType::FLOAT)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::FLOAT)
             {
                 return false;
             }
@@ -335,7 +426,7 @@ namespace Vanish
         }
         bool DataStream::Read(double &data)
         {
-            if (m_buffer[m_position] != DataType::DOUBLE)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::DOUBLE)
             {
                 return false;
             }
@@ -352,7 +443,7 @@ namespace Vanish
         }
         bool DataStream::Read(std::string &data)
         {
-            if (m_buffer[m_position] != DataType::STRING)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::STRING)
             {
                 return false;
             }
@@ -493,7 +584,7 @@ namespace Vanish
         template <typename T>
         bool DataStream::Read(std::vector<T> &data)
         {
-            if (m_buffer[m_position] != DataType::VECTOR)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::VECTOR)
             {
                 return false;
             }
@@ -512,7 +603,7 @@ namespace Vanish
         template <typename T>
         bool DataStream::Read(std::list<T> &data)
         {
-            if (m_buffer[m_position] != DataType::LIST)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::LIST)
             {
                 return false;
             }
@@ -530,7 +621,7 @@ namespace Vanish
         template <typename K, typename V>
         bool DataStream::Read(std::map<K, V> &data)
         {
-            if (m_buffer[m_position] != DataType::MAP)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::MAP)
             {
                 return false;
             }
@@ -550,7 +641,7 @@ namespace Vanish
         template <typename T>
         bool DataStream::Read(std::set<T> &data)
         {
-            if (m_buffer[m_position] != DataType::SET)
+            if (!m_borrowed.empty() || m_buffer[m_position] != DataType::SET)
             {
                 return false;
             }
@@ -653,6 +744,86 @@ namespace Vanish
             return Read_args(args...);
         }
 
+        // 每个线程独立缓存一组DataStream, 无需加锁
+        // 根据最近释放的数据大小预先分配容量, 避免每条消息都重新扩容
+        class DataStreamPool
+        {
+        public:
+            static std::unique_ptr<DataStream> Acquire();
+            static void Release(std::unique_ptr<DataStream> stream);
+
+        private:
+            static const int MAX_CACHED = 16;    // 每个线程最多缓存的数量
+            static const int MAX_OVERSIZE = 4;   // 容量超过预估值多少倍时直接丢弃, 防止偶发大消息长期占用内存
+
+            static std::vector<std::unique_ptr<DataStream>> &Cache();
+            static int &SizeHint();
+        };
+
+        std::vector<std::unique_ptr<DataStream>> &DataStreamPool::Cache()
+        {
+            thread_local std::vector<std::unique_ptr<DataStream>> cache;
+            return cache;
+        }
+
+        int &DataStreamPool::SizeHint()
+        {
+            thread_local int hint = 0;
+            return hint;
+        }
+
+        std::unique_ptr<DataStream> DataStreamPool::Acquire()
+        {
+            std::vector<std::unique_ptr<DataStream>> &cache = Cache();
+            std::unique_ptr<DataStream> stream;
+            if (cache.empty())
+            {
+                stream.reset(new DataStream());
+            }
+            else
+            {
+                stream = std::move(cache.back());
+                cache.pop_back();
+            }
+            int hint = SizeHint();
+            if ((int)stream->m_buffer.capacity() < hint)
+            {
+                stream->Reserve(hint); // 按预估大小预热
+            }
+            return stream;
+        }
+
+        void DataStreamPool::Release(std::unique_ptr<DataStream> stream)
+        {
+            if (!stream)
+            {
+                return;
+            }
+            // 用Size()而不是TotalSize(): 借用的数据不占m_buffer, 预热时只需要为m_buffer预留空间
+            int &hint = SizeHint();
+            if (hint == 0)
+            {
+                hint = stream->Size(); // 第一次直接用样本初始化, 否则前几个流会被当作过大而丢弃
+            }
+            else
+            {
+                hint = (hint * 7 + stream->Size() + 7) / 8; // 指数移动平均(向上取整), 跟随最近的消息大小
+            }
+
+            std::vector<std::unique_ptr<DataStream>> &cache = Cache();
+            if ((int)cache.size() >= MAX_CACHED)
+            {
+                return;
+            }
+            if (hint > 0 && (int)stream->m_buffer.capacity() > hint * MAX_OVERSIZE)
+            {
+                return;
+            }
+            stream->Clear();
+            stream->m_borrowThreshold = 0; // 归还后恢复默认行为, 避免下一个使用者意外进入借用模式
+            cache.push_back(std::move(stream));
+        }
+
         class ISerializable
         {
         public: